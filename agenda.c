@@ -87,6 +87,205 @@ void reset_calendar(SharedState *state)
     pthread_mutex_unlock(&state->task_mutex);
 }
 
+// Function to compare the recorded fields of two tasks
+static int task_equals(const Task *a, const Task *b)
+{
+    return strcmp(a->name, b->name) == 0 &&
+           strcmp(a->start_time, b->start_time) == 0 &&
+           strcmp(a->end_time, b->end_time) == 0 &&
+           strcmp(a->reminder_time, b->reminder_time) == 0 &&
+           strcmp(a->status, b->status) == 0 &&
+           strcmp(a->start_notification, b->start_notification) == 0 &&
+           strcmp(a->end_notification, b->end_notification) == 0;
+}
+
+// Function to drop a snapshot's references to its task records
+static void release_snapshot(Snapshot *snapshot)
+{
+    for (int i = 0; i < snapshot->num_tasks; ++i)
+    {
+        if (--snapshot->records[i]->refcount == 0)
+        {
+            free(snapshot->records[i]);
+        }
+        snapshot->records[i] = NULL;
+    }
+    snapshot->num_tasks = 0;
+}
+
+// Function to allocate the snapshot history
+int init_snapshot_history(SharedState *state, int interval)
+{
+    SnapshotHistory *history = &state->history;
+
+    // One snapshot per interval slot and per task completion, plus the end-of-day and start-of-day snapshots
+    int per_day = 2 + MAX_TASKS;
+    if (interval > 0)
+    {
+        per_day += 1440 / interval + 1;
+    }
+
+    history->capacity = SNAPSHOT_RETENTION_DAYS * per_day;
+    history->snapshots = calloc(history->capacity, sizeof(Snapshot));
+    if (history->snapshots == NULL)
+    {
+        history->capacity = 0;
+        return -1;
+    }
+    history->head = 0;
+    history->count = 0;
+    history->interval = interval;
+    history->last_slot = -1;
+    return 0;
+}
+
+// Function to release the snapshot history
+void destroy_snapshot_history(SharedState *state)
+{
+    SnapshotHistory *history = &state->history;
+
+    pthread_mutex_lock(&state->task_mutex);
+    for (int i = 0; i < history->count; ++i)
+    {
+        release_snapshot(&history->snapshots[(history->head + i) % history->capacity]);
+    }
+    free(history->snapshots);
+    history->snapshots = NULL;
+    history->capacity = 0;
+    history->count = 0;
+    pthread_mutex_unlock(&state->task_mutex);
+}
+
+// Function to record a snapshot of the calendar, sharing unchanged tasks with the previous snapshot
+void take_snapshot(SharedState *state, const struct tm *tm_info)
+{
+    SnapshotHistory *history = &state->history;
+    if (history->capacity == 0)
+        return;
+
+    pthread_mutex_lock(&state->task_mutex);
+
+    Snapshot *previous = NULL;
+    if (history->count > 0)
+    {
+        previous = &history->snapshots[(history->head + history->count - 1) % history->capacity];
+    }
+
+    // Evict the oldest snapshot when the history is full
+    Snapshot *snapshot;
+    if (history->count == history->capacity)
+    {
+        snapshot = &history->snapshots[history->head];
+        release_snapshot(snapshot);
+        history->head = (history->head + 1) % history->capacity;
+    }
+    else
+    {
+        snapshot = &history->snapshots[(history->head + history->count) % history->capacity];
+        history->count++;
+    }
+
+    snapshot->date = (tm_info->tm_year + 1900) * 10000 + (tm_info->tm_mon + 1) * 100 + tm_info->tm_mday;
+    snapshot->minute = tm_info->tm_hour * 60 + tm_info->tm_min;
+
+    for (int i = 0; i < state->num_tasks; ++i)
+    {
+        // Share the previous record if the task has not changed since
+        if (previous != NULL && previous != snapshot && i < previous->num_tasks &&
+            task_equals(&previous->records[i]->task, &state->calendar[i]))
+        {
+            snapshot->records[i] = previous->records[i];
+            snapshot->records[i]->refcount++;
+        }
+        else
+        {
+            TaskRecord *record = malloc(sizeof(TaskRecord));
+            if (record == NULL)
+            {
+                fprintf(stderr, "Error: Failed to allocate snapshot record\n");
+                break;
+            }
+            memcpy(&record->task, &state->calendar[i], sizeof(Task));
+            record->refcount = 1;
+            snapshot->records[i] = record;
+        }
+        snapshot->num_tasks = i + 1;
+    }
+
+    pthread_mutex_unlock(&state->task_mutex);
+}
+
+// Function to check whether a task is scheduled at the given minute of the day
+static int task_is_active_at(const Task *task, int total_minutes)
+{
+    int start_hour, start_min, end_hour, end_min;
+    sscanf(task->start_time, "%d:%d", &start_hour, &start_min);
+    sscanf(task->end_time, "%d:%d", &end_hour, &end_min);
+
+    int start_total_minutes = start_hour * 60 + start_min;
+    int end_total_minutes = end_hour * 60 + end_min;
+
+    return total_minutes >= start_total_minutes && total_minutes < end_total_minutes;
+}
+
+// Function to display task information as recorded on a past day
+void display_history_info(SharedState *state, const char *query)
+{
+    int year, month, day, input_hour, input_min;
+    if (sscanf(query, "%d-%d-%d %d:%d", &year, &month, &day, &input_hour, &input_min) != 5)
+    {
+        printf("Invalid history query: %s.\n\n", query);
+        return;
+    }
+    int date = year * 10000 + month * 100 + day;
+    int input_total_minutes = input_hour * 60 + input_min;
+
+    pthread_mutex_lock(&state->task_mutex);
+    SnapshotHistory *history = &state->history;
+
+    // Find the latest snapshot of that day taken at or before the requested time
+    Snapshot *snapshot = NULL;
+    for (int i = history->count - 1; i >= 0; --i)
+    {
+        Snapshot *candidate = &history->snapshots[(history->head + i) % history->capacity];
+        if (candidate->date == date && candidate->minute <= input_total_minutes)
+        {
+            snapshot = candidate;
+            break;
+        }
+    }
+
+    if (snapshot == NULL)
+    {
+        printf("No snapshot found for %04d-%02d-%02d at or before %02d:%02d.\n\n",
+               year, month, day, input_hour, input_min);
+        pthread_mutex_unlock(&state->task_mutex);
+        return;
+    }
+
+    int found = 0;
+    for (int i = 0; i < snapshot->num_tasks; ++i)
+    {
+        Task *task = &snapshot->records[i]->task;
+        if (task_is_active_at(task, input_total_minutes))
+        {
+            printf("As of %04d-%02d-%02d %02d:%02d (snapshot at %02d:%02d): Task: %s, Status: %s\n\n",
+                   year, month, day, input_hour, input_min,
+                   snapshot->minute / 60, snapshot->minute % 60, task->name, task->status);
+            found = 1;
+            break;
+        }
+    }
+
+    if (!found)
+    {
+        printf("No task found on %04d-%02d-%02d for the entered time: %02d:%02d.\n\n",
+               year, month, day, input_hour, input_min);
+    }
+
+    pthread_mutex_unlock(&state->task_mutex);
+}
+
 #ifdef DEBUG
 // Function to display time in YYYY-MM-DD HH:MM
 void display_time(struct tm *tm_info)
@@ -118,15 +317,7 @@ void display_task_info(SharedState *state, const char *time_str, int use_virtual
     {
         Task *task = &state->calendar[i];
 
-        int start_hour, start_min, end_hour, end_min;
-        sscanf(task->start_time, "%d:%d", &start_hour, &start_min);
-        sscanf(task->end_time, "%d:%d", &end_hour, &end_min);
-
-        int input_total_minutes = input_hour * 60 + input_min;
-        int start_total_minutes = start_hour * 60 + start_min;
-        int end_total_minutes = end_hour * 60 + end_min;
-
-        if (input_total_minutes >= start_total_minutes && input_total_minutes < end_total_minutes)
+        if (task_is_active_at(task, input_hour * 60 + input_min))
         {
             printf("Task: %s, Status: %s\n", task->name, task->status);
             // pthread_mutex_unlock(&state->task_mutex);
@@ -177,9 +368,6 @@ void notify_task_start(Task *task, struct tm *virtual_tm_info)
 #endif // DEBUG
     printf("Task '%s' has just started at '%s'\n", task->name, task->start_time);
     printf("*********************************************************************\n\n");
-
-    strncpy(task->start_notification, "notified", sizeof(task->start_notification) - 1);
-    task->start_notification[sizeof(task->start_notification) - 1] = '\0'; // Ensure null-termination
 }
 
 // Function to notify task end
@@ -192,42 +380,229 @@ void notify_task_end(Task *task, struct tm *virtual_tm_info)
 #endif // DEBUG
     printf("Task '%s' will end in 10 minutes\n", task->name);
     printf("*********************************************************************\n\n");
+}
 
-    strncpy(task->end_notification, "notified", sizeof(task->end_notification) - 1);
-    task->end_notification[sizeof(task->end_notification) - 1] = '\0'; // Ensure null-termination
+// Function to notify about a task whose notification window has passed
+void notify_task_missed(const Notification *notification)
+{
+    const Task *task = notification->task;
+    printf("*********************************************************************\n");
+    printf("MISSED TASK NOTIFICATION:\n");
+    if (notification->type == NOTIF_START)
+        printf("Task '%s' started at '%s' on %04d-%02d-%02d\n", task->name, task->start_time,
+               notification->date / 10000, notification->date / 100 % 100, notification->date % 100);
+    else
+        printf("Task '%s' was due to end at '%s' on %04d-%02d-%02d and is still undone\n", task->name, task->end_time,
+               notification->date / 10000, notification->date / 100 % 100, notification->date % 100);
+    printf("*********************************************************************\n\n");
 }
 
-// Function to display task notifications based on virtual time
-void display_task_notification(SharedState *state)
+// Function to remove the notification at the given queue position
+static void remove_notification(NotificationQueue *queue, int index)
 {
-    char current_time_str[6];
-    strftime(current_time_str, sizeof(current_time_str), "%H:%M", &state->virtual_tm_info);
+    memmove(&queue->items[index], &queue->items[index + 1], (queue->count - index - 1) * sizeof(Notification));
+    queue->count--;
+}
+
+// Function to queue a notification, keeping the queue ordered by priority then arrival
+void enqueue_notification(SharedState *state, NotificationType type, Task *task, int date)
+{
+    NotificationQueue *queue = &state->notifications;
+    NotificationPriority priority = (type == NOTIF_REMINDER) ? NOTIF_PRIORITY_URGENT : NOTIF_PRIORITY_NORMAL;
+
+    pthread_mutex_lock(&state->notif_mutex);
+
+    // A reminder supersedes a start notification of the same task that is still pending
+    if (type == NOTIF_REMINDER)
+    {
+        for (int i = 0; i < queue->count; ++i)
+        {
+            if (queue->items[i].task == task && queue->items[i].type == NOTIF_START && queue->items[i].date == date)
+            {
+                remove_notification(queue, i);
+                queue->coalesced_count++;
+                break;
+            }
+        }
+    }
+
+    // When the queue is full, evict the oldest notification of the lowest priority,
+    // unless it outranks the incoming one, in which case the incoming one is dropped
+    if (queue->count == NOTIF_QUEUE_LEN)
+    {
+        NotificationPriority lowest = queue->items[queue->count - 1].priority;
+        queue->overflow_count++;
+        queue->unreported_overflow++;
+        if (lowest > priority)
+        {
+            pthread_mutex_unlock(&state->notif_mutex);
+            return;
+        }
+        int victim = queue->count - 1;
+        while (victim > 0 && queue->items[victim - 1].priority == lowest)
+        {
+            victim--;
+        }
+        remove_notification(queue, victim);
+    }
+
+    // Insert after every notification of the same or higher priority
+    int index = queue->count;
+    while (index > 0 && queue->items[index - 1].priority < priority)
+    {
+        index--;
+    }
+    memmove(&queue->items[index + 1], &queue->items[index], (queue->count - index) * sizeof(Notification));
+
+    Notification *notification = &queue->items[index];
+    notification->type = type;
+    notification->priority = priority;
+    notification->task = task;
+    notification->date = date;
+    queue->count++;
+
+    pthread_mutex_unlock(&state->notif_mutex);
+}
+
+// Function to queue task notifications that are due at the given time of a day
+void queue_due_notifications(SharedState *state, const char *time_str, int date)
+{
+    // Notifications skipped over by a clock jump are still raised, except for
+    // those that were already over when the program started
+    if (state->scan_date != date)
+    {
+        strncpy(state->scan_floor, "00:00", sizeof(state->scan_floor));
+        state->scan_date = date;
+    }
 
     pthread_mutex_lock(&state->task_mutex);
     for (int i = 0; i < state->num_tasks; ++i)
     {
         Task *task = &state->calendar[i];
+        int active = strcmp(time_str, task->end_time) < 0;
+
         // Check if it's time to notify task start
-        if (strcmp(current_time_str, task->start_time) >= 0 &&
-            strcmp(current_time_str, task->reminder_time) < 0 &&
+        if (strcmp(time_str, task->start_time) >= 0 &&
+            (active || strcmp(task->start_time, state->scan_floor) >= 0) &&
             strcmp(task->start_notification, "notified") != 0)
         {
-            notify_task_start(task, &state->virtual_tm_info);
-            break; // Only notify once per task start
+            enqueue_notification(state, NOTIF_START, task, date);
+            strncpy(task->start_notification, "notified", sizeof(task->start_notification) - 1);
+            task->start_notification[sizeof(task->start_notification) - 1] = '\0'; // Ensure null-termination
         }
         // Check if it's time to notify task end
-        if (strcmp(current_time_str, task->reminder_time) >= 0 &&
-            strcmp(current_time_str, task->end_time) < 0 &&
+        if (strcmp(time_str, task->reminder_time) >= 0 &&
+            (active || strcmp(task->reminder_time, state->scan_floor) >= 0) &&
             strcmp(task->end_notification, "notified") != 0 &&
             strcmp(task->status, "undone") == 0)
         {
-            notify_task_end(task, &state->virtual_tm_info);
-            break; // Only notify once per task start
+            enqueue_notification(state, NOTIF_REMINDER, task, date);
+            strncpy(task->end_notification, "notified", sizeof(task->end_notification) - 1);
+            task->end_notification[sizeof(task->end_notification) - 1] = '\0'; // Ensure null-termination
         }
     }
     pthread_mutex_unlock(&state->task_mutex);
 }
 
+// Function to queue task notifications based on virtual time
+void queue_task_notifications(SharedState *state)
+{
+    char current_time_str[6];
+    strftime(current_time_str, sizeof(current_time_str), "%H:%M", &state->virtual_tm_info);
+    int date = (state->virtual_tm_info.tm_year + 1900) * 10000 + (state->virtual_tm_info.tm_mon + 1) * 100 + state->virtual_tm_info.tm_mday;
+
+    queue_due_notifications(state, current_time_str, date);
+}
+
+// Function to deliver pending notifications; urgent ones do not wait for a pending response
+void deliver_notifications(SharedState *state)
+{
+    NotificationQueue *queue = &state->notifications;
+
+    pthread_mutex_lock(&state->time_mutex);
+    struct tm virtual_tm_info = state->virtual_tm_info;
+    pthread_mutex_unlock(&state->time_mutex);
+
+    char current_time_str[6];
+    strftime(current_time_str, sizeof(current_time_str), "%H:%M", &virtual_tm_info);
+    int date = (virtual_tm_info.tm_year + 1900) * 10000 + (virtual_tm_info.tm_mon + 1) * 100 + virtual_tm_info.tm_mday;
+
+    int delivered = 0;
+    while (1)
+    {
+        pthread_mutex_lock(&state->notif_mutex);
+        if (queue->count == 0 ||
+            (state->awaiting_response && queue->items[0].priority != NOTIF_PRIORITY_URGENT))
+        {
+            pthread_mutex_unlock(&state->notif_mutex);
+            break;
+        }
+        Notification notification = queue->items[0];
+        remove_notification(queue, 0);
+        pthread_mutex_unlock(&state->notif_mutex);
+
+        pthread_mutex_lock(&state->task_mutex);
+        Task *task = notification.task;
+        if (notification.date != date)
+        {
+            // Raised on a previous day, the task status has been reset since
+            notify_task_missed(&notification);
+            delivered = 1;
+        }
+        else if (notification.type == NOTIF_REMINDER && strcmp(task->status, "undone") != 0)
+        {
+            // The task was checked while the reminder was pending
+            pthread_mutex_lock(&state->notif_mutex);
+            queue->stale_count++;
+            pthread_mutex_unlock(&state->notif_mutex);
+        }
+        else if (strcmp(current_time_str, task->end_time) >= 0)
+        {
+            notify_task_missed(&notification);
+            delivered = 1;
+        }
+        else if (notification.type == NOTIF_START)
+        {
+            notify_task_start(task, &virtual_tm_info);
+            delivered = 1;
+        }
+        else
+        {
+            notify_task_end(task, &virtual_tm_info);
+            delivered = 1;
+        }
+        pthread_mutex_unlock(&state->task_mutex);
+    }
+
+    pthread_mutex_lock(&state->notif_mutex);
+    if (queue->unreported_overflow > 0 && !state->awaiting_response)
+    {
+        printf("%d notification(s) dropped: notification queue full.\n\n", queue->unreported_overflow);
+        queue->unreported_overflow = 0;
+        delivered = 1;
+    }
+#ifdef DEBUG
+    if (delivered)
+    {
+        printf("DEBUG INFO: notifications pending %d, overflowed %lu, coalesced %lu, stale %lu\n\n",
+               queue->count, queue->overflow_count, queue->coalesced_count, queue->stale_count);
+    }
+#endif // DEBUG
+    pthread_mutex_unlock(&state->notif_mutex);
+
+    // Repeat the pending question after an urgent notification interrupted it
+    if (delivered && state->awaiting_response)
+    {
+        pthread_mutex_lock(&state->task_mutex);
+        if (state->current_task != NULL)
+        {
+            printf("Are you doing '%s' now? (yes/no):\n", state->current_task->name);
+        }
+        pthread_mutex_unlock(&state->task_mutex);
+    }
+    fflush(stdout);
+}
+
 // Function to validate time in the formats HH:MM or H:MM
 int is_valid_time_format(const char *time_str)
 {
@@ -288,6 +663,21 @@ int is_valid_time_format(const char *time_str)
     return 1;
 }
 
+// Function to validate a history query in the format YYYY-MM-DD HH:MM
+int is_valid_history_query(const char *query)
+{
+    int year, month, day;
+    char time_str[TIME_STR_LEN];
+    char extra;
+    if (sscanf(query, "%4d-%2d-%2d %5s%c", &year, &month, &day, time_str, &extra) != 4)
+        return 0;
+
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+        return 0;
+
+    return is_valid_time_format(time_str);
+}
+
 // Function for the clock thread to update virtual time
 void *start_clock(void *arg)
 {
@@ -299,14 +689,39 @@ void *start_clock(void *arg)
         time_t virtual_time = state->program_start_time + (time_t)elapsed_seconds;
 
         pthread_mutex_lock(&state->time_mutex);
+        struct tm previous_tm = state->virtual_tm_info;
         struct tm *local_tm = localtime(&virtual_time);
         memcpy(&state->virtual_tm_info, local_tm, sizeof(struct tm)); // Update shared virtual time info
 
         // Check for day change
-        if (state->current_day != local_tm->tm_mday)
+        if (state->current_day != state->virtual_tm_info.tm_mday)
         {
-            state->current_day = local_tm->tm_mday;
+            // Queue the rest of the previous day's notifications before their flags are cleared
+            int previous_date = (previous_tm.tm_year + 1900) * 10000 + (previous_tm.tm_mon + 1) * 100 + previous_tm.tm_mday;
+            queue_due_notifications(state, "24:00", previous_date);
+
+            // Keep the final state of the previous day before it is cleared
+            take_snapshot(state, &previous_tm);
+
+            state->current_day = state->virtual_tm_info.tm_mday;
             reset_calendar(state);
+
+            take_snapshot(state, &state->virtual_tm_info);
+            if (state->history.interval > 0)
+            {
+                state->history.last_slot = (state->virtual_tm_info.tm_hour * 60 + state->virtual_tm_info.tm_min) / state->history.interval;
+            }
+        }
+
+        // Take a snapshot whenever a new interval starts
+        if (state->history.interval > 0)
+        {
+            int slot = (state->virtual_tm_info.tm_hour * 60 + state->virtual_tm_info.tm_min) / state->history.interval;
+            if (slot != state->history.last_slot)
+            {
+                take_snapshot(state, &state->virtual_tm_info);
+                state->history.last_slot = slot;
+            }
         }
 
         pthread_mutex_unlock(&state->time_mutex);
@@ -332,6 +747,8 @@ void *display_and_interaction(void *arg)
 
             if (strcmp(state->input_buffer, "now") == 0)
                 display_task_info(state, NULL, 1);
+            else if (is_valid_history_query(state->input_buffer))
+                display_history_info(state, state->input_buffer);
             else
                 display_task_info(state, state->input_buffer, 0);
 
@@ -350,13 +767,16 @@ void *display_notifications(void *arg)
     SharedState *state = (SharedState *)arg;
     while (1)
     {
+        // Queue due notifications regardless of the prompt state so none are missed
+        pthread_mutex_lock(&state->time_mutex);
+        queue_task_notifications(state);
+        pthread_mutex_unlock(&state->time_mutex);
+
         pthread_mutex_lock(&state->print_mutex);
-        // Check if there's no task being printed  and no response awaited
-        if (!state->print_time && !state->awaiting_response)
+        // Check if there's no task being printed
+        if (!state->print_time)
         {
-            pthread_mutex_lock(&state->time_mutex);
-            display_task_notification(state);
-            pthread_mutex_unlock(&state->time_mutex);
+            deliver_notifications(state);
         }
         pthread_mutex_unlock(&state->print_mutex);
         usleep(100000); // Small delay to avoid busy-waiting
@@ -406,6 +826,8 @@ void *process_input(void *arg)
                 // Process user response for task completion confirmation
                 if (strcmp(state->input_buffer, "yes") == 0)
                 {
+                    // Hold the clock so no day rollover happens between the change and its snapshot
+                    pthread_mutex_lock(&state->time_mutex);
                     pthread_mutex_lock(&state->task_mutex);
                     // Mark current task as done
                     strncpy(state->current_task->status, "done", sizeof(state->current_task->status) - 1);
@@ -414,6 +836,10 @@ void *process_input(void *arg)
                     state->current_task = NULL;
                     pthread_mutex_unlock(&state->task_mutex);
                     state->awaiting_response = 0;
+
+                    // Record the change so historical queries see it right away
+                    take_snapshot(state, &state->virtual_tm_info);
+                    pthread_mutex_unlock(&state->time_mutex);
                 }
                 else if (strcmp(state->input_buffer, "no") == 0)
                 {
@@ -433,13 +859,14 @@ void *process_input(void *arg)
             }
             else
             {
-                if (strcmp(state->input_buffer, "now") == 0 || is_valid_time_format(state->input_buffer))
+                if (strcmp(state->input_buffer, "now") == 0 || is_valid_time_format(state->input_buffer) ||
+                    is_valid_history_query(state->input_buffer))
                 {
                     state->print_time = 1;
                 }
                 else
                 {
-                    printf("Invalid input. Please enter 'now' or a time in HH:MM format:\n");
+                    printf("Invalid input. Please enter 'now', a time in HH:MM format or a past day in YYYY-MM-DD HH:MM format:\n");
                     fflush(stdout);
                 }
             }
@@ -14,8 +14,11 @@
 #define TIME_STR_LEN 6   // Length of time string (HH:MM)
 #define STATUS_LEN 10    // Length of status string
 #define NOTIF_LEN 15     // Length of notification status string
-#define INPUT_BUF_LEN 10 // Length of input buffer
+#define INPUT_BUF_LEN 32 // Length of input buffer
 #define DELAY_SECONDS 3  // Delay duration in seconds
+#define SNAPSHOT_RETENTION_DAYS 90 // Number of days of calendar snapshots to keep
+#define SNAPSHOT_INTERVAL_MIN 60   // Default interval between snapshots in minutes (0 = only at day rollover)
+#define NOTIF_QUEUE_LEN (2 * MAX_TASKS) // Maximum number of pending notifications (a start and a reminder per task)
 
 /**
  * @struct Task
@@ -32,6 +35,88 @@ typedef struct
     char end_notification[NOTIF_LEN];   // End notification status ("not_notified" or "notified")
 } Task;
 
+/**
+ * @struct TaskRecord
+ * @brief Reference-counted copy of a task shared between calendar snapshots.
+ */
+typedef struct
+{
+    Task task;    // Task data at the time it was recorded
+    int refcount; // Number of snapshots referencing this record
+} TaskRecord;
+
+/**
+ * @struct Snapshot
+ * @brief Copy-on-write view of the calendar at a given virtual time.
+ */
+typedef struct
+{
+    int date;                         // Virtual date (YYYYMMDD)
+    int minute;                       // Virtual minute of the day (0-1439)
+    int num_tasks;                    // Number of tasks in the snapshot
+    TaskRecord *records[MAX_TASKS];   // Task records, shared with neighbouring snapshots when unchanged
+} Snapshot;
+
+/**
+ * @struct SnapshotHistory
+ * @brief Ring buffer of calendar snapshots (guarded by task_mutex).
+ */
+typedef struct
+{
+    Snapshot *snapshots; // Snapshot ring buffer
+    int capacity;        // Maximum number of snapshots kept
+    int head;            // Index of the oldest snapshot
+    int count;           // Number of snapshots stored
+    int interval;        // Interval between snapshots in minutes (0 = only at day rollover)
+    int last_slot;       // Last interval slot a snapshot was taken in
+} SnapshotHistory;
+
+/**
+ * @enum NotificationType
+ * @brief Kind of task notification.
+ */
+typedef enum
+{
+    NOTIF_START,   // Task has started
+    NOTIF_REMINDER // Task ends in 10 minutes and is still undone
+} NotificationType;
+
+/**
+ * @enum NotificationPriority
+ * @brief Delivery priority of a notification.
+ */
+typedef enum
+{
+    NOTIF_PRIORITY_NORMAL, // Delivered once no response is awaited
+    NOTIF_PRIORITY_URGENT  // Delivered ahead of normal notifications, even while a response is awaited
+} NotificationPriority;
+
+/**
+ * @struct Notification
+ * @brief Pending task notification.
+ */
+typedef struct
+{
+    NotificationType type;         // Notification kind
+    NotificationPriority priority; // Delivery priority
+    Task *task;                    // Task the notification refers to
+    int date;                      // Virtual date the notification was raised on (YYYYMMDD)
+} Notification;
+
+/**
+ * @struct NotificationQueue
+ * @brief Bounded queue of pending notifications ordered by priority (guarded by notif_mutex).
+ */
+typedef struct
+{
+    Notification items[NOTIF_QUEUE_LEN]; // Pending notifications, highest priority first then oldest first
+    int count;                           // Number of pending notifications
+    unsigned long overflow_count;        // Notifications dropped because the queue was full
+    unsigned long coalesced_count;       // Start notifications merged into a reminder
+    unsigned long stale_count;           // Notifications dropped because they no longer applied
+    int unreported_overflow;             // Overflow drops not yet reported to the user
+} NotificationQueue;
+
 /**
  * @struct SharedState
  * @brief Structure to manage shared data and synchronization.
@@ -52,6 +137,11 @@ typedef struct
     struct tm virtual_tm_info;        // Virtual time information
     pthread_mutex_t time_mutex;       // Mutex for time operations
     int current_day;                  // Current day
+    int scan_date;                    // Virtual date of the last notification scan (YYYYMMDD, guarded by time_mutex)
+    char scan_floor[TIME_STR_LEN];    // Earliest time (HH:MM) eligible for late notifications (guarded by time_mutex)
+    SnapshotHistory history;          // Calendar snapshots for historical queries
+    NotificationQueue notifications;  // Pending task notifications
+    pthread_mutex_t notif_mutex;      // Mutex for notification queue operations
 } SharedState;
 
 /**
@@ -69,6 +159,34 @@ void add_task(SharedState *state, const char *name, const char *start_time, cons
  */
 void reset_calendar(SharedState *state);
 
+/**
+ * @brief Allocates the snapshot history.
+ * @param state Pointer to the shared state structure.
+ * @param interval Interval between snapshots in minutes (0 = only at day rollover).
+ * @return 0 on success, -1 on allocation failure.
+ */
+int init_snapshot_history(SharedState *state, int interval);
+
+/**
+ * @brief Releases all snapshots and their task records.
+ * @param state Pointer to the shared state structure.
+ */
+void destroy_snapshot_history(SharedState *state);
+
+/**
+ * @brief Records a copy-on-write snapshot of the calendar.
+ * @param state Pointer to the shared state structure.
+ * @param tm_info Pointer to the tm structure containing the virtual time of the snapshot.
+ */
+void take_snapshot(SharedState *state, const struct tm *tm_info);
+
+/**
+ * @brief Displays task information for a time on a past day.
+ * @param state Pointer to the shared state structure.
+ * @param query Query string in the format "YYYY-MM-DD HH:MM".
+ */
+void display_history_info(SharedState *state, const char *query);
+
 #ifdef DEBUG
 /**
  * @brief Displays the current time (for debugging).
@@ -100,10 +218,39 @@ void notify_task_start(Task *task, struct tm *virtual_tm_info);
 void notify_task_end(Task *task, struct tm *virtual_tm_info);
 
 /**
- * @brief Displays notifications for tasks.
+ * @brief Notifies about a task whose notification window has passed.
+ * @param notification Pointer to the notification structure.
+ */
+void notify_task_missed(const Notification *notification);
+
+/**
+ * @brief Queues a notification, coalescing and applying the overflow policy.
+ * @param state Pointer to the shared state structure.
+ * @param type Notification kind.
+ * @param task Pointer to the task structure.
+ * @param date Virtual date the notification is raised on (YYYYMMDD).
+ */
+void enqueue_notification(SharedState *state, NotificationType type, Task *task, int date);
+
+/**
+ * @brief Queues notifications for tasks that are due at the given time of a day.
+ * @param state Pointer to the shared state structure (time_mutex must be held).
+ * @param time_str Time (HH:MM) up to which notifications are due; "24:00" covers the whole day.
+ * @param date Virtual date of the scan (YYYYMMDD).
+ */
+void queue_due_notifications(SharedState *state, const char *time_str, int date);
+
+/**
+ * @brief Queues notifications for tasks that are due based on virtual time.
+ * @param state Pointer to the shared state structure (time_mutex must be held).
+ */
+void queue_task_notifications(SharedState *state);
+
+/**
+ * @brief Delivers pending notifications allowed by the current prompt state.
  * @param state Pointer to the shared state structure.
  */
-void display_task_notification(SharedState *state);
+void deliver_notifications(SharedState *state);
 
 /**
  * @brief Starts the clock thread.
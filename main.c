@@ -10,6 +10,7 @@ int main()
     state.input_flag = 0;
     state.awaiting_response = 0;
     state.current_task = NULL;
+    memset(&state.notifications, 0, sizeof(state.notifications));
     state.program_start_time = time(NULL);
 
     // Initialize mutexes
@@ -28,21 +29,44 @@ int main()
         fprintf(stderr, "Error: Failed to initialize time_mutex\n");
         return EXIT_FAILURE;
     }
+    if (pthread_mutex_init(&state.notif_mutex, NULL) != 0)
+    {
+        fprintf(stderr, "Error: Failed to initialize notif_mutex\n");
+        return EXIT_FAILURE;
+    }
 
-    // Initialize the current day
+    // Initialize the current day and virtual time
     struct tm *initial_tm = localtime(&state.program_start_time);
     state.current_day = initial_tm->tm_mday;
+    memcpy(&state.virtual_tm_info, initial_tm, sizeof(struct tm));
+
+    // Only notifications due from the start time onwards are raised on the first day
+    state.scan_date = (initial_tm->tm_year + 1900) * 10000 + (initial_tm->tm_mon + 1) * 100 + initial_tm->tm_mday;
+    strftime(state.scan_floor, sizeof(state.scan_floor), "%H:%M", initial_tm);
 
     // Setup an actual clock
     state.speedup_factor = 1;
+    int snapshot_interval = SNAPSHOT_INTERVAL_MIN;
 
 #ifdef DEBUG
     // Input speedup factor
     printf("Enter the speedup factor: ");
     scanf("%lf", &state.speedup_factor);
     getchar(); // Consume the newline character left by scanf
+
+    // Input snapshot interval
+    printf("Enter the snapshot interval in minutes (0 = only at day rollover): ");
+    scanf("%d", &snapshot_interval);
+    getchar(); // Consume the newline character left by scanf
 #endif // DEBUG
 
+    // Initialize snapshot history
+    if (snapshot_interval < 0 || init_snapshot_history(&state, snapshot_interval) != 0)
+    {
+        fprintf(stderr, "Error: Failed to initialize snapshot history\n");
+        return EXIT_FAILURE;
+    }
+
     // Add calendar covering 24 hours
     add_task(&state, "Sleep", "00:00", "07:00");
     add_task(&state, "Wake up and wash", "07:00", "07:30");
@@ -78,10 +102,14 @@ int main()
     pthread_join(display_notification_thread, NULL);
     pthread_join(input_processing_thread, NULL);
 
+    // Release snapshot history
+    destroy_snapshot_history(&state);
+
     // Destroy mutexes
     pthread_mutex_destroy(&state.task_mutex);
     pthread_mutex_destroy(&state.print_mutex);
     pthread_mutex_destroy(&state.time_mutex);
+    pthread_mutex_destroy(&state.notif_mutex);
 
     return EXIT_SUCCESS;
 }